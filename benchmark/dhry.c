@@ -0,0 +1,115 @@
+/* Dhrystone-style mix of record copies, string compares and branches. */
+
+#include <stdio.h>
+#include <string.h>
+
+#define LOOPS 20000
+
+typedef enum { Ident1, Ident2, Ident3, Ident4, Ident5 } Enumeration;
+
+typedef struct Record {
+  struct Record *PtrComp;
+  Enumeration Discr;
+  Enumeration EnumComp;
+  int IntComp;
+  char StrComp[31];
+} Record;
+
+static Record Glob, Next;
+static int IntGlob;
+static char Char1Glob, Char2Glob;
+static int Array1Glob[50];
+static int Array2Glob[50][50];
+
+static Enumeration Func1(char c1, char c2)
+{
+  return (c1 != c2) ? Ident1 : Ident2;
+}
+
+static int Func2(const char *s1, const char *s2)
+{
+  int i = 1;
+  char c = 0;
+
+  while (i <= 1)
+    if (Func1(s1[i], s2[i + 1]) == Ident1) {
+      c = 'A';
+      i++;
+    }
+  if (c >= 'W' && c <= 'Z')
+    i = 7;
+  if (c == 'X')
+    return 1;
+  if (strcmp(s1, s2) > 0) {
+    IntGlob = i + 7;
+    return 1;
+  }
+  return 0;
+}
+
+static void Proc7(int a, int b, int *c)
+{
+  *c = b + a + 2;
+}
+
+static void Proc8(int *a1, int a2[][50], int i1, int i2)
+{
+  int loc = i1 + 5, i;
+
+  a1[loc] = i2;
+  a1[loc + 1] = a1[loc];
+  a1[loc + 30] = loc;
+  for (i = loc; i <= loc + 1; i++)
+    a2[loc][i] = loc;
+  a2[loc][loc - 1]++;
+  a2[loc + 20][loc] = a1[loc];
+  IntGlob = 5;
+}
+
+static void Proc1(Record *p)
+{
+  Record *q = p->PtrComp;
+
+  *q = *p;
+  p->IntComp = 5;
+  q->IntComp = p->IntComp;
+  q->PtrComp = p->PtrComp;
+  if (q->Discr == Ident1) {
+    q->IntComp = 6;
+    q->EnumComp = Func1(Char1Glob, 'C');
+    Proc7(q->IntComp, 10, &q->IntComp);
+  } else {
+    *p = *q;
+  }
+}
+
+int main()
+{
+  char s1[31], s2[31];
+  int i, a, b, c;
+  unsigned long sum = 0;
+
+  Glob.PtrComp = &Next;
+  Glob.Discr = Ident1;
+  Glob.EnumComp = Ident3;
+  Glob.IntComp = 40;
+  strcpy(Glob.StrComp, "DHRYSTONE PROGRAM, SOME STRING");
+  strcpy(s1, "DHRYSTONE PROGRAM, 1'ST STRING");
+
+  for (i = 0; i < LOOPS; i++) {
+    Char1Glob = 'A';
+    Char2Glob = 'B';
+    a = 2;
+    b = 3;
+    strcpy(s2, "DHRYSTONE PROGRAM, 2'ND STRING");
+    if (!Func2(s1, s2))
+      a = 10;
+    Proc7(a, b, &c);
+    Proc8(Array1Glob, Array2Glob, a, c);
+    Proc1(&Glob);
+    sum += c + IntGlob + Next.IntComp;
+  }
+
+  printf("%lu\n", sum);
+  return 0;
+}
@@ -0,0 +1,47 @@
+/* 16.16 fixed-point arithmetic: multiply, divide and a small FIR filter. */
+
+#include <stdio.h>
+
+#define LOOPS 2000
+
+typedef long fixed;
+
+#define FIX(x) ((fixed)((x) * 65536.0))
+
+static fixed fixmul(fixed a, fixed b)
+{
+  return (fixed)(((long long)a * b) >> 16);
+}
+
+static fixed fixdiv(fixed a, fixed b)
+{
+  return (fixed)(((long long)a << 16) / b);
+}
+
+static const fixed taps[8] = {
+  FIX(0.02), FIX(0.06), FIX(0.16), FIX(0.26),
+  FIX(0.26), FIX(0.16), FIX(0.06), FIX(0.02)
+};
+
+int main()
+{
+  fixed hist[8] = { 0 };
+  fixed x = FIX(1.5), acc = 0;
+  int i, j;
+
+  for (i = 0; i < LOOPS; i++) {
+    fixed y = 0;
+
+    for (j = 7; j > 0; j--)
+      hist[j] = hist[j - 1];
+    hist[0] = x;
+    for (j = 0; j < 8; j++)
+      y += fixmul(hist[j], taps[j]);
+
+    acc += fixdiv(y, FIX(1.25)) ^ i;
+    x = fixmul(x, FIX(0.999)) + (i & 15);
+  }
+
+  printf("%ld\n", acc);
+  return 0;
+}
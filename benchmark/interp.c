@@ -0,0 +1,47 @@
+/* Dispatch loop of a tiny stack-based bytecode interpreter. */
+
+#include <stdio.h>
+
+enum { PUSH, ADD, SUB, DUP, SWAP, JNZ, DEC, DROP, HALT };
+
+static const unsigned char program[] = {
+  PUSH, 0,               /* accumulator */
+  PUSH, 200,             /* counter */
+  SWAP, PUSH, 3, ADD, SWAP, /* 4: acc += 3 */
+  DUP, SWAP, DROP,
+  DEC, DUP, JNZ, 4,
+  DROP, HALT
+};
+
+static long run(void)
+{
+  long stack[16], *sp = stack;
+  const unsigned char *pc = program;
+  long t;
+
+  for (;;) {
+    switch (*pc++) {
+      case PUSH: *sp++ = *pc++; break;
+      case ADD: sp--; sp[-1] += sp[0]; break;
+      case SUB: sp--; sp[-1] -= sp[0]; break;
+      case DUP: *sp = sp[-1]; sp++; break;
+      case SWAP: t = sp[-1]; sp[-1] = sp[-2]; sp[-2] = t; break;
+      case JNZ: if (*--sp) pc = program + *pc; else pc++; break;
+      case DEC: sp[-1]--; break;
+      case DROP: sp--; break;
+      case HALT: return sp[-1];
+    }
+  }
+}
+
+int main()
+{
+  long sum = 0;
+  int i;
+
+  for (i = 0; i < 100; i++)
+    sum += run();
+
+  printf("%ld\n", sum);
+  return 0;
+}
@@ -0,0 +1,31 @@
+/* Block copies and string scans as done by typical application code. */
+
+#include <stdio.h>
+#include <string.h>
+
+#define LOOPS 200
+
+static char src[4096], dst[4096];
+
+int main()
+{
+  unsigned long sum = 0;
+  int i, n;
+
+  for (i = 0; i < (int)sizeof(src) - 1; i++)
+    src[i] = 'a' + i % 26;
+  src[sizeof(src) - 1] = '\0';
+
+  for (i = 0; i < LOOPS; i++) {
+    memcpy(dst, src, sizeof(src));
+    for (n = 0; n < 16; n++)
+      memcpy(dst + n * 3, src + n * 5, 250);
+    sum += strlen(dst);
+    sum += strlen(dst + (i & 255));
+    memset(dst, i, 1024);
+    sum += (unsigned char)dst[i];
+  }
+
+  printf("%lu\n", sum);
+  return 0;
+}
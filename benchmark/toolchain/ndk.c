@@ -0,0 +1,172 @@
+/* Compile time benchmark: a small Intuition program pulling in most of NDK. */
+
+#include <string.h>
+#include <exec/memory.h>
+#include <dos/dos.h>
+#include <graphics/gfxmacros.h>
+#include <intuition/intuition.h>
+#include <libraries/gadtools.h>
+#include <libraries/asl.h>
+#include <workbench/startup.h>
+#include <proto/exec.h>
+#include <proto/dos.h>
+#include <proto/graphics.h>
+#include <proto/layers.h>
+#include <proto/intuition.h>
+#include <proto/gadtools.h>
+#include <proto/asl.h>
+#include <proto/diskfont.h>
+#include <proto/utility.h>
+#include <proto/icon.h>
+#include <proto/wb.h>
+#include <proto/datatypes.h>
+#include <proto/locale.h>
+#include <proto/iffparse.h>
+#include <proto/commodities.h>
+#include <proto/rexxsyslib.h>
+#include <proto/keymap.h>
+#include <proto/console.h>
+#include <proto/timer.h>
+
+#define GAD_FILE 1
+#define GAD_QUIT 2
+
+struct Library *GadToolsBase, *AslBase;
+
+static struct NewGadget buttons[] = {
+  { 10, 20, 80, 14, "_File...", NULL, GAD_FILE, PLACETEXT_IN, NULL, NULL },
+  { 100, 20, 80, 14, "_Quit", NULL, GAD_QUIT, PLACETEXT_IN, NULL, NULL }
+};
+
+static struct Gadget *make_gadgets(struct Screen *scr, APTR vi,
+                                   struct Gadget **list)
+{
+  struct Gadget *gad = CreateContext(list);
+  int i;
+
+  for (i = 0; i < sizeof(buttons) / sizeof(buttons[0]) && gad; i++) {
+    struct NewGadget ng = buttons[i];
+
+    ng.ng_TopEdge += scr->WBorTop + scr->Font->ta_YSize;
+    ng.ng_TextAttr = scr->Font;
+    ng.ng_VisualInfo = vi;
+    gad = CreateGadget(BUTTON_KIND, gad, &ng, GT_Underscore, '_', TAG_END);
+  }
+
+  return gad;
+}
+
+static void choose_file(struct Window *win)
+{
+  struct FileRequester *fr;
+
+  fr = AllocAslRequestTags(ASL_FileRequest,
+                           ASLFR_Window, (ULONG)win,
+                           ASLFR_TitleText, (ULONG)"Pick a file",
+                           ASLFR_DoPatterns, TRUE,
+                           TAG_END);
+  if (fr) {
+    if (AslRequest(fr, NULL)) {
+      char name[256];
+
+      strncpy(name, fr->fr_Drawer, sizeof(name));
+      AddPart(name, fr->fr_File, sizeof(name));
+      SetWindowTitles(win, name, (UBYTE *)~0);
+    }
+    FreeAslRequest(fr);
+  }
+}
+
+static void draw_pattern(struct RastPort *rp, WORD w, WORD h)
+{
+  static UWORD pattern[] = { 0xAAAA, 0x5555 };
+  WORD x, y;
+
+  SetAfPt(rp, pattern, 1);
+  SetAPen(rp, 1);
+  RectFill(rp, 10, 40, w - 10, h - 10);
+  SetAfPt(rp, NULL, 0);
+
+  for (y = 40; y < h - 10; y += 8)
+    for (x = 10; x < w - 10; x += 8) {
+      SetAPen(rp, (x ^ y) & 3);
+      WritePixel(rp, x, y);
+    }
+}
+
+static void event_loop(struct Window *win)
+{
+  BOOL done = FALSE;
+
+  while (!done) {
+    struct IntuiMessage *msg;
+
+    Wait(1L << win->UserPort->mp_SigBit);
+
+    while ((msg = GT_GetIMsg(win->UserPort))) {
+      ULONG class = msg->Class;
+      struct Gadget *gad = (struct Gadget *)msg->IAddress;
+
+      GT_ReplyIMsg(msg);
+
+      switch (class) {
+        case IDCMP_CLOSEWINDOW:
+          done = TRUE;
+          break;
+        case IDCMP_GADGETUP:
+          if (gad->GadgetID == GAD_QUIT)
+            done = TRUE;
+          else if (gad->GadgetID == GAD_FILE)
+            choose_file(win);
+          break;
+        case IDCMP_REFRESHWINDOW:
+          GT_BeginRefresh(win);
+          draw_pattern(win->RPort, win->Width, win->Height);
+          GT_EndRefresh(win, TRUE);
+          break;
+      }
+    }
+  }
+}
+
+int main(void)
+{
+  struct Screen *scr;
+  struct Gadget *list = NULL;
+  APTR vi;
+
+  if (!(GadToolsBase = OpenLibrary("gadtools.library", 37)))
+    return RETURN_FAIL;
+  if (!(AslBase = OpenLibrary("asl.library", 37)))
+    return RETURN_FAIL;
+
+  if ((scr = LockPubScreen(NULL))) {
+    if ((vi = GetVisualInfo(scr, TAG_END))) {
+      if (make_gadgets(scr, vi, &list)) {
+        struct Window *win =
+          OpenWindowTags(NULL,
+                         WA_Title, (ULONG)"NDK benchmark",
+                         WA_Width, 320, WA_Height, 160,
+                         WA_Gadgets, (ULONG)list,
+                         WA_DragBar, TRUE, WA_CloseGadget, TRUE,
+                         WA_DepthGadget, TRUE, WA_Activate, TRUE,
+                         WA_IDCMP, IDCMP_CLOSEWINDOW | IDCMP_GADGETUP |
+                                   IDCMP_REFRESHWINDOW | BUTTONIDCMP,
+                         TAG_END);
+        if (win) {
+          GT_RefreshWindow(win, NULL);
+          draw_pattern(win->RPort, win->Width, win->Height);
+          event_loop(win);
+          CloseWindow(win);
+        }
+      }
+      FreeGadgets(list);
+      FreeVisualInfo(vi);
+    }
+    UnlockPubScreen(NULL, scr);
+  }
+
+  CloseLibrary(AslBase);
+  CloseLibrary(GadToolsBase);
+  return RETURN_OK;
+}
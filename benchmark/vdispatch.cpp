@@ -0,0 +1,48 @@
+// Virtual calls through a heterogeneous array of objects.
+
+#include <stdio.h>
+
+#define LOOPS 5000
+
+class Shape {
+public:
+  virtual ~Shape() {}
+  virtual long area() const = 0;
+};
+
+class Rect : public Shape {
+  long w, h;
+public:
+  Rect(long w, long h) : w(w), h(h) {}
+  long area() const { return w * h; }
+};
+
+class Square : public Shape {
+  long s;
+public:
+  Square(long s) : s(s) {}
+  long area() const { return s * s; }
+};
+
+class Triangle : public Shape {
+  long b, h;
+public:
+  Triangle(long b, long h) : b(b), h(h) {}
+  long area() const { return b * h / 2; }
+};
+
+int main()
+{
+  Rect r(3, 4);
+  Square s(5);
+  Triangle t(6, 7);
+  Shape *shapes[] = { &r, &s, &t, &s, &r, &t, &t, &r };
+  long sum = 0;
+
+  for (int i = 0; i < LOOPS; i++)
+    for (int j = 0; j < 8; j++)
+      sum += shapes[j]->area();
+
+  printf("%ld\n", sum);
+  return 0;
+}
@@ -11,6 +11,7 @@ from distutils import spawn, sysconfig
 import fileinput
 import os
 from multiprocessing import cpu_count
+import platform
 import shutil
 import site
 import subprocess
@@ -354,7 +355,7 @@ def env(**kwargs):
         os.environ[key] = value
 
 
-def recipe(name, nargs=0):
+def recipe(name, nargs=0, stamps='{stamps}'):
   def real_decorator(fn):
     @fill_in_args
     def wrapper(*args, **kwargs):
@@ -366,9 +367,9 @@ def recipe(name, nargs=0):
         target = fill_in(name)
       target = target.replace('_', '-')
       target = target.replace('/', '-')
-      stamp = path.join('{stamps}', target)
-      if not path.exists('{stamps}'):
-        mkdir('{stamps}')
+      stamp = path.join(stamps, target)
+      if not path.exists(stamps):
+        mkdir(stamps)
       if not path.exists(stamp):
         fn(*args, **kwargs)
         touch(stamp)
@@ -378,6 +379,52 @@ def recipe(name, nargs=0):
   return real_decorator
 
 
+def host_tag():
+  """
+  Host libraries can be shared by toolchains for all targets, as long as they
+  are built on the same machine with the same compiler.  Name their prefix
+  after both.
+  """
+  cc = 'clang' if platform.system() == 'Darwin' else 'gcc'
+  cc = spawn.find_executable(cc, '/usr/bin:/bin')
+  try:
+    version = subprocess.check_output([cc, '-dumpversion']).strip()
+  except (TypeError, OSError, subprocess.CalledProcessError):
+    cc, version = 'cc', 'unknown'
+  return '-'.join([platform.system(), platform.machine(),
+                   path.basename(cc), version]).lower()
+
+
+def install_host(name, prefix, confopts, kwargs):
+  prepare = kwargs.get('prepare', None)
+
+  unpack(name)
+  if prepare is not None:
+    prepare()
+  configure(name, '--prefix=' + prefix, *confopts)
+  make(name, parallel=kwargs.get('parallel', True))
+  make(name, 'install')
+
+
+@recipe('host', 1)
+def build_host(name, *confopts, **kwargs):
+  """
+  Build a tool needed by the target's build and install it into the target's
+  host prefix.  Each target builds tool versions it is known to work with.
+  """
+  install_host(name, '{host}', confopts, kwargs)
+
+
+@recipe('host-lib', 1, stamps='{hostlib}/stamps')
+def build_host_lib(name, *confopts, **kwargs):
+  """
+  Build a static library or a tool and install it into host prefix shared by
+  all targets.  The stamp is kept in the prefix, so it is built once.  Only
+  for packages whose version does not depend on the target.
+  """
+  install_host(name, '{hostlib}', confopts, kwargs)
+
+
 def extend_pythonpath(prefix):
   SITEDIR = path.join(prefix, '{sitedir}')
   try:
@@ -410,6 +457,16 @@ def pysetup(name, **kwargs):
       execute('{python}', 'setup.py', 'install', '--prefix=' + prefix)
 
 
+@recipe('host-py', 1, stamps='{hostlib}/stamps')
+def pysetup_host_lib(name):
+  """
+  Install a python package into host prefix shared by all targets, like
+  build_host_lib does with libraries.
+  """
+  unpack(name, work_dir='{build}')
+  pysetup(name, prefix='{hostlib}')
+
+
 @recipe('fetch', 1)
 def fetch(name, url):
   if url.startswith('http') or url.startswith('ftp'):
@@ -539,4 +596,5 @@ __all__ = ['setvar', 'panic', 'cmpver', 'find_executable', 'chmod', 'execute',
            'symlink', 'remove', 'move', 'find', 'textfile', 'env', 'path',
            'add_site_dir', 'find_site_dir', 'pysetup', 'pyinstall', 'recipe',
            'unpack', 'patch', 'configure', 'make', 'require_header', 'touch',
-           'pyfixbin']
+           'pyfixbin', 'fill_in', 'extend_pythonpath', 'host_tag',
+           'build_host', 'build_host_lib', 'pysetup_host_lib']
@@ -40,6 +40,26 @@ extern int debug;
 static void safename (char *);
 static void add_lib (const char *);
 static void cat (const char *, FILE *);
+static unsigned long get_long (const unsigned char *);
+static void emit_word (unsigned long);
+static void emit_long (unsigned long);
+static void emit_copy (const unsigned char *, size_t);
+static int reloc_compare (const void *, const void *);
+static size_t reloc_group_end (size_t);
+static size_t reloc_short_end (size_t, size_t);
+static void emit_relocs (void);
+static void collect_relocs (const unsigned char *, size_t);
+static size_t block_size (const unsigned char *, size_t, size_t);
+static unsigned char *read_file (const char *, size_t *);
+static size_t header_size (const unsigned char *, size_t);
+static int shorten_relocs (const unsigned char *, size_t);
+static void shorten_relocs_file (const char *);
+static int strip_debug (const unsigned char *, size_t, size_t *, size_t *);
+static void build_id (const unsigned char *, size_t, unsigned long *);
+static void write_spliced (const char *, const unsigned char *, size_t,
+			   const unsigned char *, size_t,
+			   const unsigned char *, size_t);
+static void split_debug_file (const char *);
 
 /* Names of temporary files we create.  */
 #define XLIBS_C_NAME "xlibs.c"
@@ -68,6 +88,12 @@ static int flag_baserel=0;
 /* Not zero if some of the specified libraries are dynamic.  */
 static int found_dynamic_libs=0;
 
+/* Not zero if "-mshort-relocs" was specified on GCC command line.  */
+static int flag_short_relocs=0;
+
+/* Not zero if "-msplit-debug" was specified on GCC command line.  */
+static int flag_split_debug=0;
+
 /* List of linker libraries.  */
 struct liblist *head = NULL;
 
@@ -77,7 +103,7 @@ struct liblist *head = NULL;
 int
 amigaos_do_collecting (void)
 {
-  return !flag_static;
+  return !flag_static || flag_short_relocs || flag_split_debug;
 }
 
 /* Check for presence of "-static" on the GCC command line.  We should not do
@@ -88,6 +114,10 @@ amigaos_gccopts_hook (const char *arg)
 {
   if (strncmp(arg, "-static", strlen("-static"))==0)
     flag_static=1;
+  else if (strncmp(arg, "-mshort-relocs", strlen("-mshort-relocs"))==0)
+    flag_short_relocs=1;
+  else if (strncmp(arg, "-msplit-debug", strlen("-msplit-debug"))==0)
+    flag_split_debug=1;
 }
 
 /* Replace unprintable characters with underscores.  Used by "add_lib()".  */
@@ -329,14 +359,22 @@ amigaos_prelink_hook (const char **ld1_argv, int *strip_flag)
     }
 }
 
-/* Be lazy and just call "postlink".  */
+/* Be lazy and just call "postlink".  Executables that do not use dynamic
+   libraries may get their debug information split off and relocation
+   tables shortened instead.  */
 
 void
 amigaos_postlink_hook (const char *output_file)
 {
   static const char *argv[]={"postlink", 0, 0, 0};
   if (flag_static)
-    return;
+    {
+      if (flag_split_debug)
+	split_debug_file(output_file);
+      if (flag_short_relocs)
+	shorten_relocs_file(output_file);
+      return;
+    }
 
   if (flag_baserel)
     {
@@ -347,3 +385,544 @@ amigaos_postlink_hook (const char *output_file)
     argv[1]=output_file;
   fork_execute("postlink", (char **)argv);
 }
+
+/* Relocation table compression for "-mshort-relocs".
+
+   "ld" writes HUNK_RELOC32 blocks with a 32-bit offset for every
+   relocation.  Most hunks are shorter than 64 KB and there are never more
+   than 65535 of them, so most entries fit into the word sized format of
+   HUNK_DREL32, which takes half the space and is faster to process for
+   LoadSeg().  HUNK_DREL32 is used instead of HUNK_RELOC32SHORT, because
+   that is the only identifier V37 LoadSeg() understands.  Relocations
+   that do not fit are kept in a HUNK_RELOC32 block.  */
+
+#define HUNK_NAME	0x3E8
+#define HUNK_CODE	0x3E9
+#define HUNK_DATA	0x3EA
+#define HUNK_BSS	0x3EB
+#define HUNK_RELOC32	0x3EC
+#define HUNK_SYMBOL	0x3F0
+#define HUNK_DEBUG	0x3F1
+#define HUNK_END	0x3F2
+#define HUNK_HEADER	0x3F3
+#define HUNK_DREL32	0x3F7
+#define HUNK_RELOC32SHORT 0x3FC
+
+/* Hunk identifiers may carry memory attributes in the two upper bits.  */
+#define HUNK_TYPE(ID)	((ID) & 0x3FFFFFFF)
+
+struct reloc
+{
+  unsigned long hunk;
+  unsigned long offset;
+};
+
+/* Relocations of the hunk being processed.  */
+static struct reloc *relocs;
+static size_t nrelocs, maxrelocs;
+
+/* The rewritten executable.  */
+static unsigned char *obuf;
+static size_t olen, osize;
+
+static unsigned long
+get_long (const unsigned char *p)
+{
+  return ((unsigned long)p[0] << 24) | ((unsigned long)p[1] << 16)
+	 | ((unsigned long)p[2] << 8) | (unsigned long)p[3];
+}
+
+static void
+emit_copy (const unsigned char *p, size_t n)
+{
+  if (olen + n > osize)
+    {
+      osize = (olen + n) * 2;
+      obuf = xrealloc(obuf, osize);
+    }
+  memcpy(obuf + olen, p, n);
+  olen += n;
+}
+
+static void
+emit_word (unsigned long v)
+{
+  unsigned char b[2];
+  b[0] = v >> 8;
+  b[1] = v;
+  emit_copy(b, 2);
+}
+
+static void
+emit_long (unsigned long v)
+{
+  emit_word(v >> 16);
+  emit_word(v & 0xFFFF);
+}
+
+static int
+reloc_compare (const void *a, const void *b)
+{
+  const struct reloc *r1 = (const struct reloc *)a;
+  const struct reloc *r2 = (const struct reloc *)b;
+
+  if (r1->hunk != r2->hunk)
+    return r1->hunk < r2->hunk ? -1 : 1;
+  if (r1->offset != r2->offset)
+    return r1->offset < r2->offset ? -1 : 1;
+  return 0;
+}
+
+/* Return the end of the run of relocations starting at I that refer to
+   the same hunk.  */
+
+static size_t
+reloc_group_end (size_t i)
+{
+  size_t j;
+
+  for (j = i; j < nrelocs && relocs[j].hunk == relocs[i].hunk; j++)
+    ;
+  return j;
+}
+
+/* Return the end of the leading part of group [I, J) that fits into the
+   word sized format.  Groups are sorted by offset, so that part is a
+   prefix.  */
+
+static size_t
+reloc_short_end (size_t i, size_t j)
+{
+  size_t m = i;
+
+  if (relocs[i].hunk <= 0xFFFF)
+    while (m < j && relocs[m].offset <= 0xFFFF)
+      m++;
+  return m;
+}
+
+/* Write out the collected relocations sorted by target hunk and offset:
+   first those that fit into HUNK_DREL32, then the rest as HUNK_RELOC32.  */
+
+static void
+emit_relocs (void)
+{
+  size_t i, j, k, l, m, n, nwords = 0;
+  int found = 0;
+
+  qsort(relocs, nrelocs, sizeof(struct reloc), reloc_compare);
+
+  for (i = 0; i < nrelocs; i = j)
+    {
+      j = reloc_group_end(i);
+      m = reloc_short_end(i, j);
+      for (k = i; k < m; k += n)
+	{
+	  n = (m - k > 0xFFFF) ? 0xFFFF : m - k;
+	  if (!nwords)
+	    emit_long(HUNK_DREL32);
+	  emit_word(n);
+	  emit_word(relocs[i].hunk);
+	  for (l = k; l < k + n; l++)
+	    emit_word(relocs[l].offset);
+	  nwords += 2 + n;
+	}
+    }
+  if (nwords)
+    {
+      emit_word(0);
+      /* Keep the next block longword aligned.  */
+      if (!(nwords & 1))
+	emit_word(0);
+    }
+
+  for (i = 0; i < nrelocs; i = j)
+    {
+      j = reloc_group_end(i);
+      m = reloc_short_end(i, j);
+      if (m < j)
+	{
+	  if (!found)
+	    emit_long(HUNK_RELOC32);
+	  found = 1;
+	  emit_long(j - m);
+	  emit_long(relocs[i].hunk);
+	  for (l = m; l < j; l++)
+	    emit_long(relocs[l].offset);
+	}
+    }
+  if (found)
+    emit_long(0);
+
+  nrelocs = 0;
+}
+
+/* Append relocations of the HUNK_RELOC32 block at POS to RELOCS.  The
+   block must have been checked with block_size() before.  */
+
+static void
+collect_relocs (const unsigned char *buf, size_t pos)
+{
+  unsigned long n, hunk;
+
+  for (pos += 4; (n = get_long(buf + pos)); )
+    {
+      hunk = get_long(buf + pos + 4);
+      for (pos += 8; n > 0; n--, pos += 4)
+	{
+	  if (nrelocs == maxrelocs)
+	    {
+	      maxrelocs = maxrelocs * 2 + 256;
+	      relocs = xrealloc(relocs, maxrelocs * sizeof(struct reloc));
+	    }
+	  relocs[nrelocs].hunk = hunk;
+	  relocs[nrelocs].offset = get_long(buf + pos);
+	  nrelocs++;
+	}
+    }
+}
+
+/* Return the size of the block at POS, or 0 if the block is malformed or
+   not understood.  */
+
+static size_t
+block_size (const unsigned char *buf, size_t len, size_t pos)
+{
+  size_t start = pos;
+  unsigned long n;
+
+  switch (HUNK_TYPE(get_long(buf + pos)))
+    {
+    case HUNK_NAME:
+    case HUNK_CODE:
+    case HUNK_DATA:
+    case HUNK_DEBUG:
+      if (pos + 8 > len)
+	return 0;
+      n = get_long(buf + pos + 4) & 0x3FFFFFFF;
+      pos += 8 + n * 4;
+      break;
+
+    case HUNK_BSS:
+      pos += 8;
+      break;
+
+    case HUNK_END:
+      pos += 4;
+      break;
+
+    case HUNK_RELOC32:
+      for (pos += 4; pos + 4 <= len && (n = get_long(buf + pos)); )
+	pos += 8 + n * 4;
+      pos += 4;
+      break;
+
+    case HUNK_DREL32:
+    case HUNK_RELOC32SHORT:
+      for (pos += 4; pos + 2 <= len && (n = (buf[pos] << 8) | buf[pos + 1]); )
+	pos += 4 + n * 2;
+      pos += 2;
+      if ((pos - start) & 2)
+	pos += 2;
+      break;
+
+    case HUNK_SYMBOL:
+      for (pos += 4; pos + 4 <= len && (n = get_long(buf + pos)); )
+	pos += 8 + n * 4;
+      pos += 4;
+      break;
+
+    default:
+      /* Overlays, object file blocks, or garbage.  */
+      return 0;
+    }
+
+  return pos <= len ? pos - start : 0;
+}
+
+/* Return the offset of the first hunk of the executable in BUF, or 0 if
+   its header is malformed.  */
+
+static size_t
+header_size (const unsigned char *buf, size_t len)
+{
+  size_t pos = 4;
+  unsigned long n, first, last;
+
+  if (len < 4 || get_long(buf) != HUNK_HEADER)
+    return 0;
+
+  /* Resident library names.  */
+  do
+    {
+      if (pos + 4 > len)
+	return 0;
+      n = get_long(buf + pos);
+      pos += 4 + n * 4;
+    }
+  while (n);
+
+  if (pos + 12 > len)
+    return 0;
+  first = get_long(buf + pos + 4);
+  last = get_long(buf + pos + 8);
+  pos += 12;
+  if (last < first)
+    return 0;
+
+  /* Hunk sizes with optional extended memory attributes.  */
+  for (n = first; n <= last; n++)
+    {
+      if (pos + 4 > len)
+	return 0;
+      pos += ((get_long(buf + pos) & 0xC0000000) == 0xC0000000) ? 8 : 4;
+    }
+  return pos <= len ? pos : 0;
+}
+
+/* Build a copy of the executable in BUF with shortened relocation tables
+   into OBUF.  Return 0 if the file could not be parsed.  */
+
+static int
+shorten_relocs (const unsigned char *buf, size_t len)
+{
+  size_t pos, size;
+
+  if (!(pos = header_size(buf, len)))
+    return 0;
+
+  olen = 0;
+  emit_copy(buf, pos);
+
+  while (pos + 4 <= len)
+    {
+      size_t hunk = pos, reloc_pos = 0;
+
+      /* First pass: collect all relocations up to HUNK_END.  */
+      do
+	{
+	  if (pos + 4 > len || !(size = block_size(buf, len, pos)))
+	    return 0;
+	  if (HUNK_TYPE(get_long(buf + pos)) == HUNK_RELOC32)
+	    {
+	      if (!reloc_pos)
+		reloc_pos = pos;
+	      collect_relocs(buf, pos);
+	    }
+	  pos += size;
+	}
+      while (HUNK_TYPE(get_long(buf + pos - size)) != HUNK_END);
+
+      /* Second pass: copy everything else, put the new tables in place of
+	 the first HUNK_RELOC32 block.  */
+      for (; hunk < pos; hunk += size)
+	{
+	  size = block_size(buf, len, hunk);
+	  if (hunk == reloc_pos)
+	    emit_relocs();
+	  else if (HUNK_TYPE(get_long(buf + hunk)) != HUNK_RELOC32)
+	    emit_copy(buf + hunk, size);
+	}
+    }
+
+  return pos == len;
+}
+
+/* Read the whole file FNAME into memory.  */
+
+static unsigned char *
+read_file (const char *fname, size_t *lenp)
+{
+  unsigned char *buf;
+  FILE *f;
+  long len;
+
+  f = fopen(fname, "rb");
+  if (f == NULL)
+    fatal_perror("%s", fname);
+  if (fseek(f, 0, SEEK_END) || (len = ftell(f)) < 0
+      || fseek(f, 0, SEEK_SET))
+    fatal_perror("%s", fname);
+  buf = xmalloc(len + 1);
+  if (fread(buf, 1, len, f) != (size_t)len)
+    fatal_perror("%s", fname);
+  fclose(f);
+
+  *lenp = len;
+  return buf;
+}
+
+/* Shorten relocation tables of executable FNAME in place.  The file is
+   left untouched if it cannot be parsed or would not get smaller.  */
+
+static void
+shorten_relocs_file (const char *fname)
+{
+  unsigned char *buf;
+  FILE *f;
+  size_t len;
+
+  buf = read_file(fname, &len);
+
+  if (!shorten_relocs(buf, len))
+    {
+      if (debug)
+	fprintf(stderr, "%s: unrecognized hunk structure, relocations left "
+		"untouched\n", fname);
+    }
+  else if (olen < len)
+    {
+      if (debug)
+	fprintf(stderr, "%s: relocation tables shortened by %lu bytes\n",
+		fname, (unsigned long)(len - olen));
+      f = fopen(fname, "wb");
+      if (f == NULL)
+	fatal_perror("%s", fname);
+      if (fwrite(obuf, 1, olen, f) != olen || fclose(f))
+	fatal_perror("%s", fname);
+    }
+
+  free(buf);
+}
+
+/* Debug information splitting for "-msplit-debug".
+
+   With "-g" the linker puts stabs into HUNK_DEBUG blocks and symbols into
+   HUNK_SYMBOL blocks of the executable.  They are removed from it, and the
+   executable as linked is kept next to it with ".debug" appended to its
+   name.  Both files get a small HUNK_DEBUG block at the end of the first
+   hunk: the "DLNK" tag, a build ID computed from the stripped executable
+   and the name of the side file.  Symbolisation tools use it to find the
+   side file and to check that it belongs to the executable.  LoadSeg()
+   skips HUNK_DEBUG blocks.  */
+
+#define DEBUGLINK_MAGIC	0x444C4E4B	/* "DLNK" */
+#define DEBUGLINK_SUFFIX ".debug"
+
+/* Copy the executable in BUF without HUNK_DEBUG and HUNK_SYMBOL blocks
+   into OBUF.  Offsets of the HUNK_END of the first hunk in BUF and OBUF
+   are stored in ORIG_END and STRIP_END.  Return the number of removed
+   blocks, or -1 if the file could not be parsed.  */
+
+static int
+strip_debug (const unsigned char *buf, size_t len, size_t *orig_end,
+	     size_t *strip_end)
+{
+  size_t pos, size;
+  unsigned long type;
+  int removed = 0;
+
+  if (!(pos = header_size(buf, len)))
+    return -1;
+
+  olen = 0;
+  emit_copy(buf, pos);
+  *orig_end = 0;
+
+  for (; pos + 4 <= len; pos += size)
+    {
+      if (!(size = block_size(buf, len, pos)))
+	return -1;
+      type = HUNK_TYPE(get_long(buf + pos));
+      if (type == HUNK_DEBUG || type == HUNK_SYMBOL)
+	{
+	  removed++;
+	  continue;
+	}
+      if (type == HUNK_END && !*orig_end)
+	{
+	  *orig_end = pos;
+	  *strip_end = olen;
+	}
+      emit_copy(buf + pos, size);
+    }
+
+  return (pos == len && *orig_end) ? removed : -1;
+}
+
+/* Compute the build ID of LEN bytes at P: FNV-1a hashes of the bytes at
+   offsets 0, 1, 2 and 3 modulo 4.  */
+
+static void
+build_id (const unsigned char *p, size_t len, unsigned long *id)
+{
+  size_t i;
+
+  for (i = 0; i < 4; i++)
+    id[i] = 2166136261UL;
+  for (i = 0; i < len; i++)
+    id[i & 3] = ((id[i & 3] ^ p[i]) * 16777619UL) & 0xFFFFFFFFUL;
+}
+
+/* Write three pieces of memory one after another into file FNAME.  */
+
+static void
+write_spliced (const char *fname, const unsigned char *p1, size_t n1,
+	       const unsigned char *p2, size_t n2,
+	       const unsigned char *p3, size_t n3)
+{
+  FILE *f;
+
+  f = fopen(fname, "wb");
+  if (f == NULL)
+    fatal_perror("%s", fname);
+  if (fwrite(p1, 1, n1, f) != n1 || fwrite(p2, 1, n2, f) != n2
+      || fwrite(p3, 1, n3, f) != n3 || fclose(f))
+    fatal_perror("%s", fname);
+}
+
+/* Move debug information of executable FNAME into a side file.  The file
+   is left untouched if it cannot be parsed or has no debug information.  */
+
+static void
+split_debug_file (const char *fname)
+{
+  unsigned char *buf, *name;
+  size_t len, orig_end, strip_end, stripped, longs;
+  unsigned long id[4];
+  char *side;
+  int i, removed;
+
+  buf = read_file(fname, &len);
+  removed = strip_debug(buf, len, &orig_end, &strip_end);
+
+  if (removed <= 0)
+    {
+      if (debug)
+	fprintf(stderr, removed ? "%s: unrecognized hunk structure, debug "
+		"information left in place\n" : "%s: no debug information "
+		"to split off\n", fname);
+      free(buf);
+      return;
+    }
+
+  side = concat(fname, DEBUGLINK_SUFFIX, NULL);
+
+  /* Side file name, NUL terminated and padded to a longword.  */
+  longs = strlen(lbasename(side)) / 4 + 1;
+  name = xcalloc(longs, 4);
+  strcpy((char *)name, lbasename(side));
+
+  /* Append the reference block to OBUF, it is spliced in when writing.  */
+  stripped = olen;
+  build_id(obuf, stripped, id);
+  emit_long(HUNK_DEBUG);
+  emit_long(5 + longs);
+  emit_long(DEBUGLINK_MAGIC);
+  for (i = 0; i < 4; i++)
+    emit_long(id[i]);
+  emit_copy(name, longs * 4);
+
+  write_spliced(side, buf, orig_end, obuf + stripped, olen - stripped,
+		buf + orig_end, len - orig_end);
+  write_spliced(fname, obuf, strip_end, obuf + stripped, olen - stripped,
+		obuf + strip_end, stripped - strip_end);
+
+  if (debug)
+    fprintf(stderr, "%s: %lu bytes of debug information moved to %s\n",
+	    fname, (unsigned long)(len - stripped), side);
+
+  free(name);
+  free(side);
+  free(buf);
+}
@@ -215,12 +215,17 @@ Boston, MA 02111-1307, USA.  */
 #define TARGET_ALWAYS_RESTORE_A4 (target_flags & MASK_ALWAYS_RESTORE_A4)
 
 /* Provide a dummy entry for the '-msmall-code' switch.  This is used by
-   the assembler and '*_SPEC'.  */
+   the assembler and '*_SPEC'.  Likewise '-mshort-relocs' and
+   '-msplit-debug' are only looked at by collect2.  */
 
 #undef SUBTARGET_SWITCHES
 #define SUBTARGET_SWITCHES						\
     { "small-code", 0,							\
       "" /* Undocumented. */ },						\
+    { "short-relocs", 0,						\
+      N_("Use 16-bit relocation offsets in executables") },		\
+    { "split-debug", 0,							\
+      N_("Move debug information of executables into a side file") }, \
     { "stackcheck", MASK_STACKCHECK,					\
       N_("Generate stack-check code") },				\
     { "no-stackcheck", - MASK_STACKCHECK,				\
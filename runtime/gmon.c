@@ -0,0 +1,177 @@
+/******************************************************************************/
+/*                                                                            */
+/* Call-graph profiling support for libnix (-noixemul) programs.              */
+/*                                                                            */
+/* gcc emits "lea LPn,a0; jsr mcount" after the prologue of every function   */
+/* compiled with -p or -pg.  mcount records the (caller, callee) arc and at   */
+/* exit the arcs are written to gmon.out in the format read by GNU gprof.     */
+/* Addresses are made relative to the start of the first code segment, so    */
+/* they match the symbols of the executable linked with -amiga-debug-hunk.    */
+/*                                                                            */
+/******************************************************************************/
+
+#include <string.h>
+#include <exec/types.h>
+#include <exec/memory.h>
+#include <dos/dos.h>
+#include <dos/dosextens.h>
+#include <proto/exec.h>
+#include <proto/dos.h>
+#include <stabs.h>
+
+#define ARCS_MAX 8192
+
+struct arc {
+  ULONG frompc;
+  ULONG selfpc;
+  ULONG count;
+};
+
+static struct arc *arcs;
+static ULONG text_start, text_size;
+static ULONG overflow;
+static int busy;
+
+/******************************************************************************/
+/*                                                                            */
+/* mcount entry point                                                         */
+/*                                                                            */
+/* On entry 0(sp) points into the profiled function and a5 is its frame       */
+/* pointer, so 4(a5) is the address it will return to.  Scratch registers     */
+/* are preserved because the profiled function may pass arguments in them.   */
+/*                                                                            */
+/******************************************************************************/
+
+asm(".text\n"
+    "\t.even\n"
+    "\t.globl mcount\n"
+    "mcount:\n"
+    "\tmoveml d0-d1/a0-a1,sp@-\n"
+    "\tmovel sp@(16),sp@-\n"
+    "\tmovel a5@(4),sp@-\n"
+    "\tjbsr ___mcount_internal\n"
+    "\taddql #8,sp\n"
+    "\tmoveml sp@+,d0-d1/a0-a1\n"
+    "\trts\n");
+
+void __mcount_internal(ULONG frompc, ULONG selfpc)
+{
+  ULONG i, n;
+
+  if (arcs == NULL || busy)
+    return;
+
+  busy = 1;
+
+  selfpc -= text_start;
+  frompc -= text_start;
+
+  /* Calls from outside the program (e.g. library callbacks) */
+  if (frompc >= text_size)
+    frompc = 0;
+
+  i = ((frompc >> 1) ^ (selfpc * 31)) & (ARCS_MAX - 1);
+
+  for (n = 0; n < ARCS_MAX; n++) {
+    struct arc *a = &arcs[i];
+
+    if (a->count == 0) {
+      a->frompc = frompc;
+      a->selfpc = selfpc;
+      a->count = 1;
+      break;
+    }
+
+    if (a->frompc == frompc && a->selfpc == selfpc) {
+      a->count++;
+      break;
+    }
+
+    i = (i + 1) & (ARCS_MAX - 1);
+  }
+
+  if (n == ARCS_MAX)
+    overflow++;
+
+  busy = 0;
+}
+
+/******************************************************************************/
+/*                                                                            */
+/* startup and cleanup                                                        */
+/*                                                                            */
+/******************************************************************************/
+
+void __monstartup(void)
+{
+  struct Process *me = (struct Process *)FindTask(NULL);
+  BPTR seg;
+
+  if (me->pr_CLI)
+    seg = ((struct CommandLineInterface *)BADDR(me->pr_CLI))->cli_Module;
+  else
+    seg = ((BPTR *)BADDR(me->pr_SegList))[3];
+
+  if (seg == 0)
+    return;
+
+  /* The segment size precedes the next segment pointer. */
+  text_start = (ULONG)BADDR(seg) + 4;
+  text_size = ((ULONG *)BADDR(seg))[-1] - 8;
+
+  arcs = AllocVec(ARCS_MAX * sizeof(struct arc), MEMF_PUBLIC|MEMF_CLEAR);
+}
+
+static void put_long(UBYTE *p, ULONG v)
+{
+  p[0] = v >> 24;
+  p[1] = v >> 16;
+  p[2] = v >> 8;
+  p[3] = v;
+}
+
+void __mcleanup(void)
+{
+  struct DosLibrary *DOSBase;
+  UBYTE buf[20];
+  BPTR fh;
+  ULONG i;
+
+  if (arcs == NULL)
+    return;
+
+  /* The program may have closed its own dos.library base already. */
+  if ((DOSBase = (struct DosLibrary *)OpenLibrary("dos.library", 33L))) {
+    if ((fh = Open("gmon.out", MODE_NEWFILE))) {
+      /* header: cookie, version and 12 spare bytes */
+      memset(buf, 0, sizeof(buf));
+      buf[0] = 'g'; buf[1] = 'm'; buf[2] = 'o'; buf[3] = 'n';
+      put_long(buf + 4, 1);
+      Write(fh, buf, 20);
+
+      /* call-graph arc records */
+      for (i = 0; i < ARCS_MAX; i++) {
+        if (arcs[i].count == 0)
+          continue;
+        buf[0] = 1;
+        put_long(buf + 1, arcs[i].frompc);
+        put_long(buf + 5, arcs[i].selfpc);
+        put_long(buf + 9, arcs[i].count);
+        Write(fh, buf, 13);
+      }
+
+      Close(fh);
+    }
+
+    if (overflow)
+      PutStr("mcount: arc table overflow, call graph is incomplete\n");
+
+    CloseLibrary((struct Library *)DOSBase);
+  }
+
+  FreeVec(arcs);
+  arcs = NULL;
+}
+
+ADD2INIT(__monstartup, -40);
+ADD2EXIT(__mcleanup, -40);
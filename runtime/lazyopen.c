@@ -0,0 +1,130 @@
+/******************************************************************************/
+/*                                                                            */
+/* First call library opening for libnix (-noixemul) programs.               */
+/*                                                                            */
+/* Lazy stubs from liblazystubs.a point each library base at a jump table     */
+/* entering __lazy_dispatch (see lazyopen.h).  Libraries are opened under a   */
+/* semaphore, so several tasks of the program may race for the first call.   */
+/* Once a library is open its base variable holds the real base and calls    */
+/* do not come here anymore.                                                  */
+/*                                                                            */
+/******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <exec/types.h>
+#include <exec/semaphores.h>
+#include <proto/exec.h>
+#include <stabs.h>
+#include "lazyopen.h"
+
+extern struct LazyLibrary *__LAZY_LIST__[];
+extern void __request(const char *text);
+
+static struct SignalSemaphore lock;
+static BOOL lock_ready;
+
+static void lazy_failed(const char *name, ULONG version)
+{
+  char text[80] = "Cannot open ";
+
+  strncat(text, name, sizeof(text) - strlen(text) - 1);
+  __request(text);
+}
+
+void (*__lazy_failed)(const char *name, ULONG version) = lazy_failed;
+
+static struct Library *lazy_try(struct LazyLibrary *lazy)
+{
+  struct Library *lib;
+
+  if ((lib = lazy->lib))
+    return lib;
+
+  if (!lock_ready) {
+    Forbid();
+    if (!lock_ready) {
+      InitSemaphore(&lock);
+      lock_ready = TRUE;
+    }
+    Permit();
+  }
+
+  ObtainSemaphore(&lock);
+  if (!(lib = lazy->lib) && (lib = OpenLibrary(lazy->name, lazy->version))) {
+    lazy->lib = lib;
+    *lazy->base = lib;
+  }
+  ReleaseSemaphore(&lock);
+
+  return lib;
+}
+
+struct Library *__lazy_open(struct LazyLibrary *lazy)
+{
+  struct Library *lib;
+
+  if ((lib = lazy_try(lazy)) == NULL) {
+    __lazy_failed(lazy->name, lazy->version);
+    exit(20);
+  }
+
+  return lib;
+}
+
+const char *__lazy_check(void)
+{
+  struct LazyLibrary **list;
+
+  for (list = &__LAZY_LIST__[1]; *list; list++)
+    if (lazy_try(*list) == NULL)
+      return (*list)->name;
+
+  return NULL;
+}
+
+void __exit_lazyopen(void)
+{
+  struct LazyLibrary **list;
+
+  for (list = &__LAZY_LIST__[1]; *list; list++) {
+    struct LazyLibrary *lazy = *list;
+
+    if (lazy->lib) {
+      CloseLibrary(lazy->lib);
+      lazy->lib = NULL;
+      *lazy->base = NULL;
+    }
+  }
+}
+
+/******************************************************************************/
+/*                                                                            */
+/* Jump table entry point                                                     */
+/*                                                                            */
+/* Every vector of a lazy jump table is "jsr __lazy_dispatch", so 0(sp) is    */
+/* the end of the vector called and a6 the jump table base, whose first       */
+/* longword points to the library descriptor.  All registers but a6 may hold */
+/* arguments.  The return address is replaced with the same vector of the     */
+/* opened library, so rts continues the original call.                       */
+/*                                                                            */
+/******************************************************************************/
+
+asm(".text\n"
+    "\t.even\n"
+    "\t.globl ___lazy_dispatch\n"
+    "___lazy_dispatch:\n"
+    "\tmoveml d0-d1/a0-a1,sp@-\n"
+    "\tmovel a6@,sp@-\n"
+    "\tjbsr ___lazy_open\n"
+    "\taddql #4,sp\n"
+    "\tmovel sp@(16),a1\n"
+    "\tsubql #6,a1\n"
+    "\tsubl a6,a1\n"
+    "\taddl d0,a1\n"
+    "\tmovel a1,sp@(16)\n"
+    "\tmovel d0,a6\n"
+    "\tmoveml sp@+,d0-d1/a0-a1\n"
+    "\trts\n");
+
+ADD2EXIT(__exit_lazyopen, -60);
@@ -0,0 +1,35 @@
+#ifndef _LAZYOPEN_H_
+#define _LAZYOPEN_H_
+
+/*
+ * Libraries opened on first call, for programs linked with -llazystubs.
+ *
+ * Until the first call the library base variable points at a jump table of
+ * the library's size whose every vector enters __lazy_dispatch.  It opens
+ * the library, stores the real base in the variable and continues at the
+ * vector that was called, so later calls go straight to the library.
+ *
+ * The base is not a real library until then: code reading its fields or
+ * comparing it to NULL has to call __lazy_check first.  Programs linked with
+ * -resident cannot use lazy stubs.
+ */
+
+#include <exec/types.h>
+#include <exec/libraries.h>
+
+struct LazyLibrary {
+  struct Library **base;
+  const char *name;
+  ULONG version;
+  struct Library *lib;
+};
+
+/* Opens all lazy libraries at once.  Returns the name of the first library
+   that could not be opened or NULL if all of them are available. */
+const char *__lazy_check(void);
+
+/* Called when the first call to a library fails to open it.  The default
+   shows a requester.  The program exits with code 20 afterwards. */
+extern void (*__lazy_failed)(const char *name, ULONG version);
+
+#endif
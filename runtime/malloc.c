@@ -0,0 +1,211 @@
+/******************************************************************************/
+/*                                                                            */
+/* Size-class memory allocator for libnix (-noixemul) programs.               */
+/*                                                                            */
+/* Link with -lpmalloc to replace libnix's malloc, calloc, realloc and free.  */
+/* Memory comes from an exec memory pool.  Small blocks are rounded up to a   */
+/* size class and kept on per-class free lists when released, so they never  */
+/* go back to the system allocator and cannot fragment it.  Larger blocks go  */
+/* straight to the pool.  The whole pool is released at program exit, after   */
+/* which malloc returns NULL and free does nothing.                           */
+/*                                                                            */
+/* Like libnix's allocator this one is not safe for use by several tasks.    */
+/*                                                                            */
+/******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <exec/types.h>
+#include <exec/memory.h>
+#include <exec/execbase.h>
+#include <proto/exec.h>
+#include <stabs.h>
+
+/* amiga.lib versions of the pool functions for exec.library < V39 */
+APTR LibCreatePool(ULONG requirements, ULONG puddleSize, ULONG threshSize);
+void LibDeletePool(APTR poolHeader);
+APTR LibAllocPooled(APTR poolHeader, ULONG memSize);
+void LibFreePooled(APTR poolHeader, APTR memory, ULONG memSize);
+
+#define PUDDLE_SIZE 16384
+#define THRESH_SIZE 4096
+
+/* Sizes of the classes, the last one is the largest pooled block. */
+static const ULONG class_size[] = {
+  8, 16, 24, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024
+};
+
+#define CLASSES (sizeof(class_size) / sizeof(class_size[0]))
+#define SMALL_MAX 1024
+
+struct block {
+  struct block *next;
+};
+
+static APTR pool;
+static BOOL native;
+static BOOL exited;
+static struct block *free_list[CLASSES];
+static UBYTE size_class[SMALL_MAX / 8 + 1];
+
+/******************************************************************************/
+/*                                                                            */
+/* pool management                                                            */
+/*                                                                            */
+/******************************************************************************/
+
+static APTR pool_alloc(ULONG size)
+{
+  return native ? AllocPooled(pool, size) : LibAllocPooled(pool, size);
+}
+
+static void pool_free(APTR mem, ULONG size)
+{
+  if (native)
+    FreePooled(pool, mem, size);
+  else
+    LibFreePooled(pool, mem, size);
+}
+
+static void init_pmalloc(void)
+{
+  ULONG i, c = 0;
+
+  for (i = 0; i <= SMALL_MAX / 8; i++) {
+    while (class_size[c] < i * 8)
+      c++;
+    size_class[i] = c;
+  }
+
+  native = SysBase->LibNode.lib_Version >= 39;
+  pool = native ? CreatePool(MEMF_ANY, PUDDLE_SIZE, THRESH_SIZE)
+                : LibCreatePool(MEMF_ANY, PUDDLE_SIZE, THRESH_SIZE);
+}
+
+void __exit_pmalloc(void)
+{
+  if (pool) {
+    if (native)
+      DeletePool(pool);
+    else
+      LibDeletePool(pool);
+    pool = NULL;
+    memset(free_list, 0, sizeof(free_list));
+  }
+  exited = TRUE;
+}
+
+/******************************************************************************/
+/*                                                                            */
+/* ANSI C interface                                                           */
+/*                                                                            */
+/* Every block is preceded by a longword holding its usable size.             */
+/*                                                                            */
+/******************************************************************************/
+
+void *malloc(size_t size)
+{
+  ULONG *mem;
+
+  if (pool == NULL) {
+    /* Destructors may allocate after the pool is gone.  Do not create a
+       new one, nothing would release it. */
+    if (exited)
+      return NULL;
+    /* Constructors may allocate before ours would have run. */
+    init_pmalloc();
+    if (pool == NULL)
+      return NULL;
+  }
+
+  if (size <= SMALL_MAX) {
+    ULONG c = size_class[(size + 7) >> 3];
+    struct block *b = free_list[c];
+
+    if (b) {
+      free_list[c] = b->next;
+      return b;
+    }
+
+    size = class_size[c];
+  } else {
+    /* Do not let rounding up and the size longword wrap around. */
+    if (size > ~0UL - 3 - sizeof(ULONG))
+      return NULL;
+    size = (size + 3) & ~3;
+  }
+
+  if ((mem = pool_alloc(size + sizeof(ULONG))) == NULL)
+    return NULL;
+
+  *mem++ = size;
+  return mem;
+}
+
+void free(void *ptr)
+{
+  ULONG *mem = ptr;
+  ULONG size;
+
+  if (ptr == NULL || pool == NULL)
+    return;
+
+  size = *--mem;
+
+  if (size <= SMALL_MAX) {
+    struct block *b = ptr;
+    ULONG c = size_class[size >> 3];
+
+    b->next = free_list[c];
+    free_list[c] = b;
+  } else {
+    pool_free(mem, size + sizeof(ULONG));
+  }
+}
+
+void *calloc(size_t nmemb, size_t size)
+{
+  size_t total = nmemb * size;
+  void *ptr;
+
+  if (size && total / size != nmemb)
+    return NULL;
+
+  if ((ptr = malloc(total)))
+    memset(ptr, 0, total);
+
+  return ptr;
+}
+
+void *realloc(void *ptr, size_t size)
+{
+  ULONG old;
+  void *new;
+
+  if (ptr == NULL)
+    return malloc(size);
+
+  if (size == 0) {
+    free(ptr);
+    return NULL;
+  }
+
+  /* Every block went away with the pool. */
+  if (pool == NULL)
+    return NULL;
+
+  old = ((ULONG *)ptr)[-1];
+
+  /* Shrinking, or growing within the same size class */
+  if (size <= old && (old <= SMALL_MAX || size > SMALL_MAX))
+    return ptr;
+
+  if ((new = malloc(size))) {
+    memcpy(new, ptr, size < old ? size : old);
+    free(ptr);
+  }
+
+  return new;
+}
+
+ADD2EXIT(__exit_pmalloc, -50);
@@ -0,0 +1,18 @@
+/* Host stand-in for <exec/execbase.h> used by runtime tests. */
+
+#ifndef EXEC_EXECBASE_H
+#define EXEC_EXECBASE_H
+
+#include <exec/types.h>
+
+struct Library {
+  UWORD lib_Version;
+};
+
+struct ExecBase {
+  struct Library LibNode;
+};
+
+extern struct ExecBase *SysBase;
+
+#endif
@@ -0,0 +1,8 @@
+/* Host stand-in for <exec/memory.h> used by runtime tests. */
+
+#ifndef EXEC_MEMORY_H
+#define EXEC_MEMORY_H
+
+#define MEMF_ANY 0L
+
+#endif
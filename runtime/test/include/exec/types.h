@@ -0,0 +1,15 @@
+/* Host stand-in for <exec/types.h> used by runtime tests. */
+
+#ifndef EXEC_TYPES_H
+#define EXEC_TYPES_H
+
+typedef void *APTR;
+typedef unsigned long ULONG;
+typedef unsigned short UWORD;
+typedef unsigned char UBYTE;
+typedef short BOOL;
+
+#define TRUE 1
+#define FALSE 0
+
+#endif
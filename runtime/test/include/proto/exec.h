@@ -0,0 +1,14 @@
+/* Host stand-in for <proto/exec.h> used by runtime tests.  The functions
+   are provided by the test driver. */
+
+#ifndef PROTO_EXEC_H
+#define PROTO_EXEC_H
+
+#include <exec/types.h>
+
+APTR CreatePool(ULONG requirements, ULONG puddleSize, ULONG threshSize);
+void DeletePool(APTR poolHeader);
+APTR AllocPooled(APTR poolHeader, ULONG memSize);
+void FreePooled(APTR poolHeader, APTR memory, ULONG memSize);
+
+#endif
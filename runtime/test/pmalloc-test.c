@@ -0,0 +1,350 @@
+/******************************************************************************/
+/*                                                                            */
+/* Host test and benchmark of the pooled allocator (runtime/malloc.c).        */
+/*                                                                            */
+/* malloc.c is compiled with its functions renamed to pmalloc, pfree,         */
+/* pcalloc and prealloc.  Exec memory pools are replaced by the stubs below,  */
+/* which check that every block is given back with the size it was           */
+/* allocated with.  Run "make check" (under AddressSanitizer) or "make bench".*/
+/* The allocator stays shut down after __exit_pmalloc(), so every run tests   */
+/* one exec version, given as the argument (default 39).                      */
+/*                                                                            */
+/******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <exec/types.h>
+#include <exec/execbase.h>
+#include <proto/exec.h>
+
+void *pmalloc(size_t size);
+void pfree(void *ptr);
+void *pcalloc(size_t nmemb, size_t size);
+void *prealloc(void *ptr, size_t size);
+void __exit_pmalloc(void);
+
+static struct ExecBase execbase = { { 39 } };
+struct ExecBase *SysBase = &execbase;
+
+static int failures;
+
+#define CHECK(cond)                                                       \
+  do {                                                                    \
+    if (!(cond)) {                                                        \
+      fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__,    \
+              #cond);                                                     \
+      failures++;                                                         \
+    }                                                                     \
+  } while (0)
+
+/******************************************************************************/
+/*                                                                            */
+/* exec pool stubs                                                            */
+/*                                                                            */
+/******************************************************************************/
+
+struct puddle {
+  struct puddle *prev, *next;
+  ULONG size;
+};
+
+struct pool {
+  struct puddle head;
+  int native;
+};
+
+static int pools;
+static long pooled_blocks;
+
+static APTR create_pool(int native)
+{
+  struct pool *p = calloc(1, sizeof(struct pool));
+
+  p->head.prev = p->head.next = &p->head;
+  p->native = native;
+  pools++;
+  return p;
+}
+
+static void delete_pool(APTR poolHeader, int native)
+{
+  struct pool *p = poolHeader;
+
+  CHECK(p->native == native);
+  while (p->head.next != &p->head) {
+    struct puddle *b = p->head.next;
+
+    b->prev->next = b->next;
+    b->next->prev = b->prev;
+    free(b);
+    pooled_blocks--;
+  }
+  free(p);
+  pools--;
+}
+
+static APTR alloc_pooled(APTR poolHeader, ULONG memSize, int native)
+{
+  struct pool *p = poolHeader;
+  struct puddle *b;
+
+  CHECK(p->native == native);
+  if (memSize > (1UL << 30) || !(b = malloc(sizeof(*b) + memSize)))
+    return NULL;
+  b->size = memSize;
+  b->next = p->head.next;
+  b->prev = &p->head;
+  b->next->prev = b;
+  p->head.next = b;
+  pooled_blocks++;
+  return b + 1;
+}
+
+static void free_pooled(APTR poolHeader, APTR memory, ULONG memSize,
+                        int native)
+{
+  struct puddle *b = (struct puddle *)memory - 1;
+
+  CHECK(((struct pool *)poolHeader)->native == native);
+  CHECK(b->size == memSize);
+  b->prev->next = b->next;
+  b->next->prev = b->prev;
+  free(b);
+  pooled_blocks--;
+}
+
+APTR CreatePool(ULONG requirements, ULONG puddleSize, ULONG threshSize)
+{
+  return create_pool(1);
+}
+
+void DeletePool(APTR poolHeader)
+{
+  delete_pool(poolHeader, 1);
+}
+
+APTR AllocPooled(APTR poolHeader, ULONG memSize)
+{
+  return alloc_pooled(poolHeader, memSize, 1);
+}
+
+void FreePooled(APTR poolHeader, APTR memory, ULONG memSize)
+{
+  free_pooled(poolHeader, memory, memSize, 1);
+}
+
+APTR LibCreatePool(ULONG requirements, ULONG puddleSize, ULONG threshSize)
+{
+  return create_pool(0);
+}
+
+void LibDeletePool(APTR poolHeader)
+{
+  delete_pool(poolHeader, 0);
+}
+
+APTR LibAllocPooled(APTR poolHeader, ULONG memSize)
+{
+  return alloc_pooled(poolHeader, memSize, 0);
+}
+
+void LibFreePooled(APTR poolHeader, APTR memory, ULONG memSize)
+{
+  free_pooled(poolHeader, memory, memSize, 0);
+}
+
+/******************************************************************************/
+/*                                                                            */
+/* tests                                                                      */
+/*                                                                            */
+/******************************************************************************/
+
+static const ULONG class_size[] = {
+  8, 16, 24, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024
+};
+
+#define BLOCK_SIZE(ptr) (((ULONG *)(ptr))[-1])
+
+static void test_size_classes(void)
+{
+  size_t n;
+
+  for (n = 0; n <= 1100; n++) {
+    UBYTE *p = pmalloc(n);
+    ULONG want = (n + 3) & ~3;
+    int c;
+
+    CHECK(p != NULL);
+    for (c = 0; c < 14; c++)
+      if (class_size[c] >= n) {
+        want = class_size[c];
+        break;
+      }
+    CHECK(BLOCK_SIZE(p) == want);
+    memset(p, 0xAA, n);
+    pfree(p);
+  }
+}
+
+static void test_reuse(void)
+{
+  void *a = pmalloc(40), *b;
+
+  pfree(a);
+  b = pmalloc(48);
+  CHECK(a == b);
+  pfree(b);
+
+  a = pmalloc(2000);
+  pfree(a);
+  CHECK(pooled_blocks >= 0);
+}
+
+static void test_realloc(void)
+{
+  char *p = prealloc(NULL, 10), *q;
+  int i;
+
+  CHECK(p != NULL);
+  for (i = 0; i < 10; i++)
+    p[i] = i;
+
+  /* Growing within the size class keeps the block. */
+  CHECK(prealloc(p, 16) == p);
+  /* Shrinking keeps the block. */
+  CHECK(prealloc(p, 4) == p);
+
+  q = prealloc(p, 300);
+  CHECK(q != NULL && BLOCK_SIZE(q) == 384);
+  for (i = 0; i < 10; i++)
+    CHECK(q[i] == i);
+
+  p = prealloc(q, 5000);
+  CHECK(p != NULL && BLOCK_SIZE(p) == 5000);
+  for (i = 0; i < 10; i++)
+    CHECK(p[i] == i);
+
+  /* Large blocks shrink in place, but not into a size class. */
+  CHECK(prealloc(p, 3000) == p);
+  q = prealloc(p, 100);
+  CHECK(q != p && BLOCK_SIZE(q) == 128);
+
+  CHECK(prealloc(q, 0) == NULL);
+}
+
+static void test_calloc(void)
+{
+  UBYTE *p = pmalloc(100);
+  size_t i;
+
+  memset(p, 0xFF, 100);
+  pfree(p);
+
+  p = pcalloc(25, 4);
+  CHECK(p != NULL);
+  for (i = 0; i < 100; i++)
+    CHECK(p[i] == 0);
+  pfree(p);
+
+  CHECK(pcalloc(~(size_t)0 / 2 + 1, 2) == NULL);
+  CHECK(pcalloc(2, ~(size_t)0 / 2 + 1) == NULL);
+}
+
+static void test_huge(void)
+{
+  CHECK(pmalloc(~(size_t)0) == NULL);
+  CHECK(pmalloc(~(size_t)0 - 3) == NULL);
+  CHECK(pmalloc(~(size_t)0 - 8) == NULL);
+}
+
+static void test_exit(void)
+{
+  int i;
+
+  for (i = 0; i < 100; i++)
+    pmalloc(i * 37);
+
+  __exit_pmalloc();
+  CHECK(pools == 0);
+  CHECK(pooled_blocks == 0);
+
+  /* Nothing may bring the pool back, it would never be deleted. */
+  CHECK(pmalloc(16) == NULL);
+  CHECK(pmalloc(4096) == NULL);
+  CHECK(pcalloc(4, 4) == NULL);
+  CHECK(prealloc(NULL, 64) == NULL);
+  pfree(NULL);
+  CHECK(pools == 0);
+  CHECK(pooled_blocks == 0);
+}
+
+static void run_tests(int version)
+{
+  execbase.LibNode.lib_Version = version;
+
+  test_size_classes();
+  test_reuse();
+  test_realloc();
+  test_calloc();
+  test_huge();
+  test_exit();
+}
+
+/******************************************************************************/
+/*                                                                            */
+/* benchmark                                                                  */
+/*                                                                            */
+/******************************************************************************/
+
+#define SLOTS 4096
+#define ROUNDS 4000000
+
+static double bench(void *(*alloc)(size_t), void (*release)(void *))
+{
+  static void *slot[SLOTS];
+  unsigned seed = 1;
+  clock_t start = clock();
+  long i;
+
+  for (i = 0; i < ROUNDS; i++) {
+    unsigned r = seed = seed * 1103515245 + 12345;
+    unsigned k = (r >> 8) % SLOTS;
+    size_t size = (r >> 20) & 3 ? (r >> 4) % 256 : (r >> 4) % 4096;
+
+    if (slot[k]) {
+      release(slot[k]);
+      slot[k] = NULL;
+    } else {
+      slot[k] = alloc(size);
+    }
+  }
+
+  for (i = 0; i < SLOTS; i++) {
+    release(slot[i]);
+    slot[i] = NULL;
+  }
+
+  return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+int main(int argc, char **argv)
+{
+  if (argc > 1 && !strcmp(argv[1], "bench")) {
+    printf("pmalloc: %.3fs\n", bench(pmalloc, pfree));
+    printf("malloc:  %.3fs\n", bench(malloc, free));
+    __exit_pmalloc();
+    return 0;
+  }
+
+  run_tests(argc > 1 ? atoi(argv[1]) : 39);
+
+  if (failures) {
+    printf("%d checks failed\n", failures);
+    return 1;
+  }
+
+  printf("all checks passed\n");
+  return 0;
+}